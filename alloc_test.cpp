@@ -0,0 +1,81 @@
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "sudoku.hpp"
+#include "test_check.hpp"
+
+// every heap allocation in the program goes through here, so that we can count them
+static std::atomic<long long> allocations = 0;
+
+void* operator new(std::size_t size) {
+    ++allocations;
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+// solves every sudoku with both engines, writing all output into fixed buffers
+auto solve_batch(SolverContext& context, const std::vector<std::string>& sudokus) -> int {
+    std::array<char, 81> solution;
+    std::array<char, SudokuBoard::RENDER_SIZE> rendered;
+    int solved = 0;
+    for (const auto& line : sudokus) {
+        solved += context.solve(line, solution, false);
+        solved += context.solve(line, solution, true);
+        context.render(rendered);
+        for (const auto& s : context.current().solutions()) {
+            s.write_string(solution);
+        }
+    }
+    return solved;
+}
+
+int main() {
+    // Create an input filestream
+    std::ifstream sudokus("test_set.txt");
+
+    // Make sure the file is open
+    if (!sudokus.is_open()) throw std::runtime_error("Could not open file");
+
+    // read everything up front, so that only the solving is counted
+    std::vector<std::string> batch;
+    std::string line;
+    while (std::getline(sudokus, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        batch.push_back(line);
+    }
+
+    allocations = 0;
+    SolverContext context;
+
+    // building the clause database allocates, which shows the counter is hooked up
+    check(allocations > 0, "allocations counted");
+
+    // the first pass grows the solver's buffers to their working size
+    solve_batch(context, batch);
+
+    allocations = 0;
+    auto solved = solve_batch(context, batch);
+    long long counted = allocations;
+
+    check(solved == (int)batch.size() * 2, "all solved");
+    check(counted == 0, "steady state allocations");
+    if (counted != 0) {
+        std::cerr << counted << " allocations in the steady state\n";
+    }
+    return test_status();
+}
@@ -0,0 +1,364 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "grader.hpp"
+
+constexpr auto SUDOKU_LINE_LEN = 81;
+
+// Latency histogram with 16 buckets per power of two, so every bucket is within ~6% of its values.
+// Bucket boundaries are fixed, so histograms from separate runs can simply be added together,
+// and percentiles taken from the sum are exactly those a single run over all the input would give.
+class LatencyHistogram {
+    static constexpr int SUB_BITS = 4;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BITS;
+    static constexpr int BUCKETS = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+
+    std::array<long long, BUCKETS> counts = {};
+
+   public:
+    static auto bucket_of(uint64_t micros) -> int {
+        if (micros < SUB_BUCKETS) {
+            return (int)micros;
+        }
+        int exponent = std::bit_width(micros) - 1;
+        int shift = exponent - SUB_BITS;
+        return (shift + 1) * SUB_BUCKETS + (int)((micros >> shift) - SUB_BUCKETS);
+    }
+
+    // the largest value that lands in a bucket
+    static auto upper_bound_of(int bucket) -> uint64_t {
+        if (bucket < SUB_BUCKETS) {
+            return bucket;
+        }
+        int shift = bucket / SUB_BUCKETS - 1;
+        uint64_t mantissa = bucket % SUB_BUCKETS + SUB_BUCKETS;
+        return ((mantissa + 1) << shift) - 1;
+    }
+
+    void add(long long micros) {
+        ++counts[bucket_of((uint64_t)std::max(micros, 0LL))];
+    }
+
+    void add_bucket(int bucket, long long count) {
+        counts[bucket] += count;
+    }
+
+    void merge(const LatencyHistogram& other) {
+        for (int i = 0; i < BUCKETS; ++i) {
+            counts[i] += other.counts[i];
+        }
+    }
+
+    // the upper bound of the bucket holding the value at fraction q of the way through
+    auto percentile(double q) const -> uint64_t {
+        long long total = 0;
+        for (auto c : counts) {
+            total += c;
+        }
+        auto rank = std::max(1LL, (long long)(q * total + 0.999999));
+        long long seen = 0;
+        for (int i = 0; i < BUCKETS; ++i) {
+            seen += counts[i];
+            if (seen >= rank) {
+                return upper_bound_of(i);
+            }
+        }
+        return 0;
+    }
+
+    // non-empty buckets only, as "bucket:count" pairs
+    void write(std::ostream& out) const {
+        int used = (int)std::count_if(counts.begin(), counts.end(), [](long long c) { return c != 0; });
+        out << "histogram " << used;
+        for (int i = 0; i < BUCKETS; ++i) {
+            if (counts[i]) {
+                out << ' ' << i << ':' << counts[i];
+            }
+        }
+        out << '\n';
+    }
+
+    static constexpr auto bucket_count() -> int {
+        return BUCKETS;
+    }
+};
+
+// What a run of the benchmark, or one shard of it, has to say about the sudokus it solved.
+// Partial results from every shard of a run merge into the result the whole run would have had.
+struct BenchResult {
+    static constexpr std::string_view MAGIC = "sudoku-bench-partial";
+    static constexpr int VERSION = 4;
+
+    struct Record {
+        long long index = -1;
+        long long micros = 0;
+        std::array<char, SUDOKU_LINE_LEN> sudoku;
+
+        Record() {
+            sudoku.fill('-');
+        }
+
+        void set(long long i, long long t, std::string_view s) {
+            index = i;
+            micros = t;
+            sudoku.fill('-');
+            std::copy_n(s.begin(), std::min<size_t>(s.size(), SUDOKU_LINE_LEN), sudoku.begin());
+        }
+
+        auto view() const -> std::string_view {
+            return std::string_view(sudoku.data(), SUDOKU_LINE_LEN);
+        }
+
+        // whether a sudoku beats this record for hardest (or easiest) so far.
+        // ties go to the earliest sudoku, as they would in a single pass over the file.
+        auto beaten_by(long long i, long long t, bool harder) const -> bool {
+            if (i == -1) return false;
+            if (index == -1) return true;
+            if (t != micros) return harder ? t > micros : t < micros;
+            return i < index;
+        }
+    };
+
+    int shard = 0;
+    int shard_count = 1;
+    bool use_cdcl = false;
+    bool graded = false;
+
+    // this shard covers records [first, last) of a run over `records` records,
+    // read from an input whose first `records` lines hash to `fingerprint`.
+    long long first = 0;
+    long long last = 0;
+    long long records = 0;
+    uint64_t fingerprint = 0;
+
+    long long solved = 0;
+    long long solve_time = 0;
+    long long wall_time = 0;
+    Record hardest, easiest;
+    LatencyHistogram latencies;
+    std::vector<Record> failures;
+
+    // sudokus and their total solve time, by the hardest technique a person would need.
+    // only filled in when the run grades its sudokus, which `graded` records.
+    std::array<long long, Grading::TECHNIQUE_COUNT> difficulty_counts = {};
+    std::array<long long, Grading::TECHNIQUE_COUNT> difficulty_times = {};
+
+    auto total() const -> long long {
+        return solved + (long long)failures.size();
+    }
+
+    void add(long long index, std::string_view sudoku, long long micros, bool success) {
+        if (success) {
+            ++solved;
+        } else {
+            failures.emplace_back().set(index, micros, sudoku);
+        }
+        solve_time += micros;
+        latencies.add(micros);
+        if (hardest.beaten_by(index, micros, true)) {
+            hardest.set(index, micros, sudoku);
+        }
+        if (easiest.beaten_by(index, micros, false)) {
+            easiest.set(index, micros, sudoku);
+        }
+    }
+
+    void add_difficulty(const Grading::Grade& grade, long long micros) {
+        if (grade.valid) {
+            ++difficulty_counts[(int)grade.hardest];
+            difficulty_times[(int)grade.hardest] += micros;
+        }
+    }
+
+    void merge(const BenchResult& other) {
+        solved += other.solved;
+        solve_time += other.solve_time;
+        wall_time += other.wall_time;
+        if (hardest.beaten_by(other.hardest.index, other.hardest.micros, true)) hardest = other.hardest;
+        if (easiest.beaten_by(other.easiest.index, other.easiest.micros, false)) easiest = other.easiest;
+        latencies.merge(other.latencies);
+        for (int t = 0; t < Grading::TECHNIQUE_COUNT; ++t) {
+            difficulty_counts[t] += other.difficulty_counts[t];
+            difficulty_times[t] += other.difficulty_times[t];
+        }
+        failures.insert(failures.end(), other.failures.begin(), other.failures.end());
+        std::sort(failures.begin(), failures.end(), [](const Record& a, const Record& b) { return a.index < b.index; });
+    }
+
+    void write(std::ostream& out) const {
+        auto record = [&out](std::string_view name, const Record& r) {
+            out << name << ' ' << r.index << ' ' << r.micros << ' ' << r.view() << '\n';
+        };
+        out << MAGIC << ' ' << VERSION << '\n';
+        out << "shard " << shard << ' ' << shard_count << '\n';
+        out << "engine " << (use_cdcl ? "cdcl" : "dfs") << '\n';
+        out << "records " << first << ' ' << last << ' ' << records << '\n';
+        out << "input " << std::hex << fingerprint << std::dec << '\n';
+        out << "solved " << solved << '\n';
+        out << "solve_time " << solve_time << '\n';
+        out << "wall_time " << wall_time << '\n';
+        record("hardest", hardest);
+        record("easiest", easiest);
+        latencies.write(out);
+        out << "difficulty " << (graded ? "graded" : "ungraded") << ' ' << Grading::TECHNIQUE_COUNT;
+        for (int t = 0; t < Grading::TECHNIQUE_COUNT; ++t) {
+            out << ' ' << difficulty_counts[t] << ':' << difficulty_times[t];
+        }
+        out << '\n';
+        out << "failures " << failures.size() << '\n';
+        for (const auto& f : failures) {
+            record("failure", f);
+        }
+    }
+
+    // reads what write() wrote, returning false if the input is malformed
+    auto read(std::istream& in) -> bool {
+        std::string key, text;
+        int version;
+        auto expect = [&](std::string_view name) { return bool(in >> key) && key == name; };
+        auto record = [&](std::string_view name, Record& r) {
+            return expect(name) && (in >> r.index >> r.micros >> text) && (r.set(r.index, r.micros, text), true);
+        };
+
+        if (!expect(MAGIC) || !(in >> version) || version != VERSION) return false;
+        if (!expect("shard") || !(in >> shard >> shard_count)) return false;
+        if (shard_count < 1 || shard < 0 || shard >= shard_count) return false;
+        if (!expect("engine") || !(in >> text)) return false;
+        use_cdcl = text == "cdcl";
+        if (!expect("records") || !(in >> first >> last >> records)) return false;
+        if (first < 0 || first > last || last > records) return false;
+        if (!expect("input") || !(in >> std::hex >> fingerprint >> std::dec)) return false;
+        if (!expect("solved") || !(in >> solved)) return false;
+        if (!expect("solve_time") || !(in >> solve_time)) return false;
+        if (!expect("wall_time") || !(in >> wall_time)) return false;
+        if (!record("hardest", hardest) || !record("easiest", easiest)) return false;
+
+        int used;
+        if (!expect("histogram") || !(in >> used)) return false;
+        for (int i = 0; i < used; ++i) {
+            int bucket;
+            char colon;
+            long long count;
+            if (!(in >> bucket >> colon >> count) || colon != ':' || bucket < 0 || bucket >= LatencyHistogram::bucket_count()) {
+                return false;
+            }
+            latencies.add_bucket(bucket, count);
+        }
+
+        int techniques;
+        if (!expect("difficulty") || !(in >> text)) return false;
+        graded = text == "graded";
+        if (!(in >> techniques) || techniques != Grading::TECHNIQUE_COUNT) return false;
+        for (int t = 0; t < techniques; ++t) {
+            char colon;
+            if (!(in >> difficulty_counts[t] >> colon >> difficulty_times[t]) || colon != ':') return false;
+        }
+
+        size_t failure_count;
+        if (!expect("failures") || !(in >> failure_count)) return false;
+        failures.resize(failure_count);
+        for (auto& f : failures) {
+            if (!record("failure", f)) return false;
+        }
+        // every record in the shard's range was either solved or failed
+        return total() == last - first;
+    }
+
+    void report(std::ostream& out) const {
+        out << std::endl
+            << "hardest sudoku "
+            << hardest.view() << " took "
+            << std::right << std::setw(6) << hardest.micros << "μs." << std::endl
+            << "easiest sudoku "
+            << easiest.view() << " took "
+            << std::right << std::setw(6) << easiest.micros << "μs." << std::endl
+            << "latency p50: "
+            << std::right << std::setw(6) << latencies.percentile(0.50) << "μs, p90: "
+            << std::right << std::setw(6) << latencies.percentile(0.90) << "μs, p99: "
+            << std::right << std::setw(6) << latencies.percentile(0.99) << "μs." << std::endl
+            << "solved " << solved << " of " << total() << " sudokus." << std::endl;
+        for (const auto& f : failures) {
+            out << "failed sudoku " << f.view() << " (line " << f.index + 1 << ")." << std::endl;
+        }
+        for (int t = 0; t < Grading::TECHNIQUE_COUNT; ++t) {
+            auto count = difficulty_counts[t];
+            if (!count) continue;
+            auto rating = Grading::RATINGS[t];
+            out << "difficulty " << rating / 10 << "." << rating % 10
+                << " (" << Grading::name_of((Grading::Technique)t) << "): "
+                << count << " sudokus, averaging "
+                << difficulty_times[t] / count << "μs." << std::endl;
+        }
+        out << "total solve time: "
+            << std::right << std::setw(6) << solve_time << "μs." << std::endl
+            << "total time: "
+            << std::right << std::setw(6) << wall_time << "μs." << std::endl;
+    }
+};
+
+// merges the partial results of every shard of one run into merged, after checking that they
+// really are one run: the same engine, grading, shard count, input and record count, with each shard given
+// exactly once and their record ranges tiling [0, records) with no gaps or overlaps.
+// problems are written to errors, and false returned.
+inline auto merge_shards(std::vector<BenchResult> parts, BenchResult& merged, std::ostream& errors) -> bool {
+    if (parts.empty()) {
+        errors << "no partial results provided.\n";
+        return false;
+    }
+
+    const auto& run = parts[0];
+    std::vector<bool> seen(run.shard_count, false);
+    for (const auto& part : parts) {
+        if (part.shard_count != run.shard_count || part.use_cdcl != run.use_cdcl || part.graded != run.graded ||
+            part.records != run.records || part.fingerprint != run.fingerprint) {
+            errors << "partial results come from different runs.\n";
+            return false;
+        }
+        if (seen[part.shard]) {
+            errors << "shard " << part.shard << "/" << run.shard_count << " given more than once.\n";
+            return false;
+        }
+        seen[part.shard] = true;
+    }
+    for (int shard = 0; shard < run.shard_count; ++shard) {
+        if (!seen[shard]) {
+            errors << "shard " << shard << "/" << run.shard_count << " is missing.\n";
+            return false;
+        }
+    }
+
+    std::sort(parts.begin(), parts.end(), [](const BenchResult& a, const BenchResult& b) { return a.first < b.first; });
+    long long covered = 0;
+    for (const auto& part : parts) {
+        if (part.first != covered) {
+            errors << "shard " << part.shard << "/" << run.shard_count << " starts at record " << part.first
+                   << ", but the shards before it end at record " << covered << ".\n";
+            return false;
+        }
+        covered = part.last;
+    }
+    if (covered != run.records) {
+        errors << "the shards cover " << covered << " of " << run.records << " records.\n";
+        return false;
+    }
+
+    merged = BenchResult();
+    merged.shard_count = run.shard_count;
+    merged.use_cdcl = run.use_cdcl;
+    merged.graded = run.graded;
+    merged.last = merged.records = run.records;
+    merged.fingerprint = run.fingerprint;
+    for (const auto& part : parts) {
+        merged.merge(part);
+    }
+    return true;
+}
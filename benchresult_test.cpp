@@ -0,0 +1,142 @@
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "benchresult.hpp"
+#include "test_check.hpp"
+
+auto report_of(const BenchResult& result) -> std::string {
+    std::stringstream out;
+    result.report(out);
+    return out.str();
+}
+
+// a made-up grade for the i-th sudoku
+auto grade_of(size_t i) -> Grading::Grade {
+    Grading::Grade grade;
+    grade.hardest = (Grading::Technique)(i * i % Grading::TECHNIQUE_COUNT);
+    grade.valid = i % 89 != 0;
+    return grade;
+}
+
+int main() {
+    // made-up timings, with plenty of ties and the odd failure
+    std::mt19937 rng(2022);
+    std::vector<long long> times(1000);
+    std::vector<std::string> sudokus(times.size());
+    for (size_t i = 0; i < times.size(); ++i) {
+        times[i] = rng() % 4 ? rng() % 200 : rng() % 100000;
+        sudokus[i] = std::to_string(i) + std::string(81, '-');
+    }
+
+    BenchResult whole;
+    for (size_t i = 0; i < times.size(); ++i) {
+        whole.add(i, sudokus[i], times[i], i % 97 != 0);
+        whole.add_difficulty(grade_of(i), times[i]);
+    }
+
+    for (int shard_count : {1, 2, 3, 7, 16}) {
+        // each shard goes through a partial result file, as it would between processes
+        std::vector<std::string> files;
+        for (int shard = 0; shard < shard_count; ++shard) {
+            BenchResult part;
+            part.shard = shard;
+            part.shard_count = shard_count;
+            part.first = times.size() * shard / shard_count;
+            part.last = times.size() * (shard + 1) / shard_count;
+            part.records = times.size();
+            part.fingerprint = 0xfeedface;
+            part.graded = true;
+            for (auto i = part.first; i < part.last; ++i) {
+                part.add(i, sudokus[i], times[i], i % 97 != 0);
+                part.add_difficulty(grade_of(i), times[i]);
+            }
+            std::stringstream out;
+            part.write(out);
+            files.push_back(out.str());
+        }
+
+        // merge in reverse, since the order the files are given in shouldn't matter
+        std::vector<BenchResult> parts;
+        bool read_ok = true;
+        for (auto it = files.rbegin(); it != files.rend(); ++it) {
+            std::stringstream in(*it);
+            read_ok = read_ok && parts.emplace_back().read(in);
+        }
+        BenchResult merged;
+        std::stringstream errors;
+        read_ok = read_ok && merge_shards(parts, merged, errors);
+
+        auto name = std::to_string(shard_count) + " shards";
+        check(read_ok && merged.graded && report_of(merged) == report_of(whole), name + " merge to the same report");
+        check(merged.latencies.percentile(0.99) == whole.latencies.percentile(0.99), name + " have the same p99");
+    }
+
+    // bucket bounds are monotonic, and every value lands in a bucket that covers it
+    bool buckets_ok = true;
+    for (uint64_t v : {0ULL, 1ULL, 15ULL, 16ULL, 17ULL, 31ULL, 32ULL, 1000ULL, 123456789ULL, ~0ULL}) {
+        auto b = LatencyHistogram::bucket_of(v);
+        buckets_ok = buckets_ok && b < LatencyHistogram::bucket_count() && LatencyHistogram::upper_bound_of(b) >= v;
+        buckets_ok = buckets_ok && (b == 0 || LatencyHistogram::upper_bound_of(b - 1) < v);
+    }
+    check(buckets_ok, "histogram buckets");
+
+    std::stringstream garbage("not a partial result");
+    BenchResult bad;
+    check(!bad.read(garbage), "malformed partial result is rejected");
+
+    // shard numbers that don't describe a shard of a run
+    for (auto shard : {"7 2", "0 -1", "-1 3", "0 0"}) {
+        std::stringstream out;
+        BenchResult part;
+        part.write(out);
+        auto text = out.str();
+        text.replace(text.find("shard 0 1"), 9, std::string("shard ") + shard);
+        std::stringstream in(text);
+        check(!BenchResult().read(in), std::string("shard ") + shard + " is rejected");
+    }
+
+    // a shard whose records don't fit its range
+    std::stringstream short_shard;
+    BenchResult unfilled;
+    unfilled.last = unfilled.records = 5;
+    unfilled.add(0, sudokus[0], times[0], true);
+    unfilled.write(short_shard);
+    check(!BenchResult().read(short_shard), "shard missing records is rejected");
+
+    // shards that don't make up exactly one run
+    auto shard_of = [&](int shard, int shard_count, long long first, long long last, long long records) {
+        BenchResult part;
+        part.shard = shard;
+        part.shard_count = shard_count;
+        part.first = first;
+        part.last = last;
+        part.records = records;
+        part.fingerprint = 0xfeedface;
+        for (auto i = first; i < last; ++i) {
+            part.add(i, sudokus[i], times[i], true);
+        }
+        return part;
+    };
+    auto merges = [](const std::vector<BenchResult>& parts) {
+        BenchResult merged;
+        std::stringstream errors;
+        return merge_shards(parts, merged, errors);
+    };
+    auto other_input = shard_of(1, 2, 5, 10, 10);
+    other_input.fingerprint = 0xdeadbeef;
+    check(merges({shard_of(0, 2, 0, 5, 10), shard_of(1, 2, 5, 10, 10)}), "matching shards merge");
+    check(!merges({shard_of(0, 2, 0, 5, 10), shard_of(1, 2, 100, 200, 200)}), "shards of different counts are rejected");
+    check(!merges({shard_of(0, 2, 0, 5, 10), other_input}), "shards of different inputs are rejected");
+    auto graded = shard_of(1, 2, 5, 10, 10);
+    graded.graded = true;
+    check(!merges({shard_of(0, 2, 0, 5, 10), graded}), "graded and ungraded shards are rejected");
+    check(!merges({shard_of(0, 2, 0, 4, 10), shard_of(1, 2, 5, 10, 10)}), "shards with a gap are rejected");
+    check(!merges({shard_of(0, 2, 0, 6, 10), shard_of(1, 2, 5, 10, 10)}), "overlapping shards are rejected");
+    check(!merges({shard_of(0, 2, 0, 5, 10), shard_of(1, 2, 5, 9, 10)}), "shards short of the total are rejected");
+    check(!merges({shard_of(0, 2, 0, 5, 10), shard_of(0, 2, 5, 10, 10)}), "repeated shards are rejected");
+    check(!merges({shard_of(0, 2, 0, 5, 10)}), "missing shards are rejected");
+    return test_status();
+}
@@ -0,0 +1,491 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace CDCL {
+
+// A conflict-driven clause learning solver specialised to sudoku.
+// Each (cell, digit) pair is a boolean variable, and the rules of sudoku are encoded as clauses:
+// every cell, and every digit in each row, column and box, takes exactly one value ("at least one"
+// as a 9-literal clause, "at most one" as 36 binary clauses). Givens are assigned at level zero.
+// Search is the usual loop of unit propagation with two watched literals per clause, first-UIP
+// conflict analysis, non-chronological backjumping and Luby restarts. Learned nogoods are kept
+// between restarts, so a dead end found once is never explored again, which is what bounds the
+// worst case on sudokus built to defeat chronological backtracking.
+class Solver {
+   public:
+    static constexpr int DEFAULT_RESTART_BASE = 64;
+    static constexpr int DEFAULT_MAX_LEARNTS = 4096;
+
+    using matrix = std::array<std::array<int, 9>, 9>;
+
+    static constexpr int VARS = 729;
+    static constexpr int LITS = VARS * 2;
+
+    // literals are 2 * var + sign, where a set sign bit means the negated variable.
+    static constexpr auto var_of(int cell, int digit) -> int {
+        return cell * 9 + (digit - 1);
+    }
+
+    static constexpr auto pos(int var) -> int {
+        return var * 2;
+    }
+
+    static constexpr auto neg(int var) -> int {
+        return var * 2 + 1;
+    }
+
+   private:
+    static constexpr int8_t UNDEF = -1;
+    static constexpr int NO_REASON = -1;
+    // room preallocated for learned clauses, as a multiple of max_learnts.
+    // running past it between restarts just grows the buffers, which then stay grown.
+    static constexpr int LEARNT_HEADROOM = 2;
+    static constexpr int LEARNT_LENGTH_GUESS = 16;
+
+    struct Clause {
+        int start;
+        int size;
+    };
+
+    // clause storage: all literals live in one arena, problem clauses first, then learned ones.
+    std::vector<int> literals;
+    std::vector<Clause> clauses;
+    int problem_clauses = 0;
+    int problem_literals = 0;
+    // propagation reorders the literals of problem clauses as it moves their watches,
+    // so the original order and watches are kept to start every puzzle from the same state.
+    std::vector<int> pristine_literals;
+    std::array<std::vector<int>, LITS> pristine_watches;
+
+    // watch lists, indexed by the literal whose falsification should wake the clause.
+    // problem clauses and learned clauses are watched separately, so that dropping every
+    // learned clause between puzzles is just a matter of clearing the second set.
+    std::array<std::vector<int>, LITS> problem_watches;
+    std::array<std::vector<int>, LITS> learnt_watches;
+
+    std::array<int8_t, VARS> assigns;
+    std::array<int, VARS> level;
+    std::array<int, VARS> reason;
+    std::array<bool, VARS> polarity;
+    std::array<bool, VARS> seen;
+    std::array<double, VARS> activity;
+    double var_inc = 1.0;
+
+    std::vector<int> trail;
+    std::vector<int> trail_lim;
+    size_t qhead = 0;
+
+    // scratch space for conflict analysis
+    std::vector<int> learnt;
+
+    // conflicts allowed before the first restart, scaled by the luby sequence after that
+    int restart_base;
+    // learned clauses kept before the database is halved at the next restart
+    int max_learnts;
+
+    long long conflicts = 0;
+    long long reductions = 0;
+
+    auto value(int lit) const -> int8_t {
+        auto a = assigns[lit >> 1];
+        return a == UNDEF ? UNDEF : (int8_t)(a ^ (lit & 1));
+    }
+
+    auto decision_level() const -> int {
+        return (int)trail_lim.size();
+    }
+
+    void enqueue(int lit, int from) {
+        auto v = lit >> 1;
+        assigns[v] = (int8_t)!(lit & 1);
+        level[v] = decision_level();
+        reason[v] = from;
+        trail.push_back(lit);
+    }
+
+    auto add_clause(const int* lits, int size) -> int {
+        auto index = (int)clauses.size();
+        clauses.push_back({(int)literals.size(), size});
+        literals.insert(literals.end(), lits, lits + size);
+        return index;
+    }
+
+    void watch(int index, bool is_learnt) {
+        auto& watches = is_learnt ? learnt_watches : problem_watches;
+        auto lits = &literals[clauses[index].start];
+        watches[lits[0]].push_back(index);
+        watches[lits[1]].push_back(index);
+    }
+
+    void add_exactly_one(const std::array<int, 9>& vars) {
+        std::array<int, 9> alo;
+        for (int i = 0; i < 9; ++i) {
+            alo[i] = pos(vars[i]);
+        }
+        add_clause(alo.data(), 9);
+        for (int i = 0; i < 9; ++i) {
+            for (int j = i + 1; j < 9; ++j) {
+                std::array<int, 2> amo = {neg(vars[i]), neg(vars[j])};
+                add_clause(amo.data(), 2);
+            }
+        }
+    }
+
+    void build_problem() {
+        std::array<int, 9> vars;
+        for (int cell = 0; cell < 81; ++cell) {
+            for (int d = 1; d <= 9; ++d) {
+                vars[d - 1] = var_of(cell, d);
+            }
+            add_exactly_one(vars);
+        }
+        for (int d = 1; d <= 9; ++d) {
+            for (int unit = 0; unit < 9; ++unit) {
+                for (int i = 0; i < 9; ++i) {
+                    vars[i] = var_of(unit * 9 + i, d);
+                }
+                add_exactly_one(vars);
+                for (int i = 0; i < 9; ++i) {
+                    vars[i] = var_of(i * 9 + unit, d);
+                }
+                add_exactly_one(vars);
+                for (int i = 0; i < 9; ++i) {
+                    int row = (unit / 3) * 3 + i / 3;
+                    int col = (unit % 3) * 3 + i % 3;
+                    vars[i] = var_of(row * 9 + col, d);
+                }
+                add_exactly_one(vars);
+            }
+        }
+        problem_clauses = (int)clauses.size();
+        problem_literals = (int)literals.size();
+        pristine_literals = literals;
+        for (int index = 0; index < problem_clauses; ++index) {
+            auto lits = &literals[clauses[index].start];
+            pristine_watches[lits[0]].push_back(index);
+            pristine_watches[lits[1]].push_back(index);
+        }
+
+        // a problem clause can end up watched by any of its literals,
+        // so give every watch list room for all the clauses it appears in.
+        std::array<int, LITS> occurrences = {};
+        for (auto lit : literals) {
+            ++occurrences[lit];
+        }
+        for (int lit = 0; lit < LITS; ++lit) {
+            problem_watches[lit].reserve(occurrences[lit]);
+            learnt_watches[lit].reserve(LEARNT_LENGTH_GUESS);
+        }
+        clauses.reserve(problem_clauses + max_learnts * LEARNT_HEADROOM);
+        literals.reserve(problem_literals + max_learnts * LEARNT_HEADROOM * LEARNT_LENGTH_GUESS);
+    }
+
+    // visits every clause in ws that watches false_lit. returns a conflicting clause, or NO_REASON.
+    auto propagate_watches(std::vector<int>& ws, int false_lit, bool is_learnt) -> int {
+        auto& other_watches = is_learnt ? learnt_watches : problem_watches;
+        size_t i = 0, j = 0;
+        auto n = ws.size();
+        while (i < n) {
+            auto index = ws[i++];
+            auto lits = &literals[clauses[index].start];
+            auto size = clauses[index].size;
+            // keep the falsified watch in the second slot
+            if (lits[0] == false_lit) {
+                std::swap(lits[0], lits[1]);
+            }
+            // the clause is already satisfied by its other watch
+            if (value(lits[0]) == 1) {
+                ws[j++] = index;
+                continue;
+            }
+            // look for a replacement watch that isn't false
+            bool moved = false;
+            for (int k = 2; k < size; ++k) {
+                if (value(lits[k]) != 0) {
+                    std::swap(lits[1], lits[k]);
+                    other_watches[lits[1]].push_back(index);
+                    moved = true;
+                    break;
+                }
+            }
+            if (moved) {
+                continue;
+            }
+            ws[j++] = index;
+            if (value(lits[0]) == 0) {
+                // every literal is false, so keep the remaining watches and report the conflict
+                while (i < n) {
+                    ws[j++] = ws[i++];
+                }
+                ws.resize(j);
+                return index;
+            }
+            // unit: the first watch is implied
+            enqueue(lits[0], index);
+        }
+        ws.resize(j);
+        return NO_REASON;
+    }
+
+    auto propagate() -> int {
+        while (qhead < trail.size()) {
+            auto false_lit = trail[qhead++] ^ 1;
+            auto confl = propagate_watches(problem_watches[false_lit], false_lit, false);
+            if (confl == NO_REASON) {
+                confl = propagate_watches(learnt_watches[false_lit], false_lit, true);
+            }
+            if (confl != NO_REASON) {
+                qhead = trail.size();
+                return confl;
+            }
+        }
+        return NO_REASON;
+    }
+
+    void bump(int v) {
+        activity[v] += var_inc;
+        if (activity[v] > 1e100) {
+            for (auto& a : activity) {
+                a *= 1e-100;
+            }
+            var_inc *= 1e-100;
+        }
+    }
+
+    // derives the first-UIP nogood from a conflict into `learnt`, with the asserting
+    // literal first and the literal from the backjump level second. returns the backjump level.
+    auto analyze(int confl) -> int {
+        learnt.clear();
+        learnt.push_back(0);
+        int path_count = 0;
+        int p = -1;
+        auto index = (int)trail.size() - 1;
+        do {
+            auto lits = &literals[clauses[confl].start];
+            auto size = clauses[confl].size;
+            // the implied literal of a reason clause is always its first
+            for (int k = p == -1 ? 0 : 1; k < size; ++k) {
+                auto q = lits[k];
+                auto v = q >> 1;
+                if (seen[v] || level[v] == 0) {
+                    continue;
+                }
+                seen[v] = true;
+                bump(v);
+                if (level[v] == decision_level()) {
+                    ++path_count;
+                } else {
+                    learnt.push_back(q);
+                }
+            }
+            // walk back along the trail to the next literal involved in the conflict
+            while (!seen[trail[index] >> 1]) {
+                --index;
+            }
+            p = trail[index--];
+            confl = reason[p >> 1];
+            seen[p >> 1] = false;
+            --path_count;
+        } while (path_count > 0);
+        learnt[0] = p ^ 1;
+
+        int backjump = 0;
+        for (size_t k = 1; k < learnt.size(); ++k) {
+            seen[learnt[k] >> 1] = false;
+            if (level[learnt[k] >> 1] > backjump) {
+                backjump = level[learnt[k] >> 1];
+                std::swap(learnt[1], learnt[k]);
+            }
+        }
+        var_inc *= 1 / 0.95;
+        return backjump;
+    }
+
+    void cancel_until(int target_level) {
+        if (decision_level() <= target_level) {
+            return;
+        }
+        for (auto i = (int)trail.size() - 1; i >= trail_lim[target_level]; --i) {
+            auto v = trail[i] >> 1;
+            polarity[v] = !(trail[i] & 1);
+            assigns[v] = UNDEF;
+        }
+        trail.resize(trail_lim[target_level]);
+        trail_lim.resize(target_level);
+        qhead = trail.size();
+    }
+
+    // the most active unassigned variable, or -1 if every variable is assigned
+    auto pick_branch_var() const -> int {
+        int best = -1;
+        for (int v = 0; v < VARS; ++v) {
+            if (assigns[v] == UNDEF && (best == -1 || activity[v] > activity[best])) {
+                best = v;
+            }
+        }
+        return best;
+    }
+
+    // learned clauses are only ever dropped at a restart, when nothing above level zero is
+    // assigned, so none of them can be the reason for a literal that analysis will look at.
+    void reduce_learnts() {
+        if ((int)clauses.size() - problem_clauses <= max_learnts) {
+            return;
+        }
+        for (auto& ws : learnt_watches) {
+            ws.clear();
+        }
+        for (auto lit : trail) {
+            reason[lit >> 1] = NO_REASON;
+        }
+        // keep the shorter half, which prune the most search.
+        // ties are broken by age, since std::stable_sort may allocate.
+        auto first = clauses.begin() + problem_clauses;
+        auto kept = first + max_learnts / 2;
+        std::nth_element(first, kept, clauses.end(),
+                         [](const Clause& a, const Clause& b) { return a.size != b.size ? a.size < b.size : a.start < b.start; });
+        clauses.erase(kept, clauses.end());
+        // compacting in place is only safe in arena order, where every clause moves down
+        // onto space that has already been copied out of.
+        std::sort(first, clauses.end(), [](const Clause& a, const Clause& b) { return a.start < b.start; });
+        auto write = problem_literals;
+        for (auto index = problem_clauses; index < (int)clauses.size(); ++index) {
+            auto& c = clauses[index];
+            if (c.start != write) {
+                std::copy(literals.begin() + c.start, literals.begin() + c.start + c.size, literals.begin() + write);
+            }
+            c.start = write;
+            write += c.size;
+            watch(index, true);
+        }
+        literals.resize(write);
+        ++reductions;
+        // the new watches may sit on literals already false at level zero, so wake them all again
+        qhead = 0;
+    }
+
+    // the luby sequence 1, 1, 2, 1, 1, 2, 4, 1, 1, 2, ... scaling the conflicts allowed per restart
+    static auto luby(long long i) -> long long {
+        long long size = 1, seq = 0;
+        while (size < i + 1) {
+            ++seq;
+            size = 2 * size + 1;
+        }
+        while (size - 1 != i) {
+            size = (size - 1) >> 1;
+            --seq;
+            i = i % size;
+        }
+        return 1LL << seq;
+    }
+
+    // drops everything learned from the previous puzzle and puts the problem clauses back as
+    // they were built, so that each solve depends only on its own givens.
+    // no memory is allocated or freed, the buffers are only truncated and refilled.
+    void reset() {
+        for (int lit = 0; lit < LITS; ++lit) {
+            problem_watches[lit].assign(pristine_watches[lit].begin(), pristine_watches[lit].end());
+            learnt_watches[lit].clear();
+        }
+        clauses.resize(problem_clauses);
+        literals.resize(problem_literals);
+        std::copy(pristine_literals.begin(), pristine_literals.end(), literals.begin());
+        assigns.fill(UNDEF);
+        reason.fill(NO_REASON);
+        level.fill(0);
+        polarity.fill(true);
+        seen.fill(false);
+        activity.fill(0.0);
+        var_inc = 1.0;
+        trail.clear();
+        trail_lim.clear();
+        qhead = 0;
+        conflicts = 0;
+        reductions = 0;
+    }
+
+   public:
+    Solver(int learnt_limit = DEFAULT_MAX_LEARNTS, int restart_conflicts = DEFAULT_RESTART_BASE)
+        : restart_base(restart_conflicts), max_learnts(learnt_limit) {
+        trail.reserve(VARS);
+        trail_lim.reserve(VARS);
+        learnt.reserve(VARS);
+        build_problem();
+    }
+
+    // the number of conflicts the last call to solve() ran into
+    auto conflict_count() const -> long long {
+        return conflicts;
+    }
+
+    // the number of times the last call to solve() halved its learned clauses
+    auto reduction_count() const -> long long {
+        return reductions;
+    }
+
+    // solves the grid in place, using 0 for unassigned cells. returns false if it has no solution.
+    auto solve(matrix& grid) -> bool {
+        reset();
+
+        for (int cell = 0; cell < 81; ++cell) {
+            auto d = grid[cell / 9][cell % 9];
+            if (d == 0) {
+                continue;
+            }
+            // contradictory givens are caught by the first round of propagation
+            enqueue(pos(var_of(cell, d)), NO_REASON);
+        }
+
+        long long restarts = 0;
+        long long conflicts_until_restart = restart_base * luby(restarts);
+        while (true) {
+            auto confl = propagate();
+            if (confl != NO_REASON) {
+                ++conflicts;
+                --conflicts_until_restart;
+                if (decision_level() == 0) {
+                    return false;  // the givens alone lead to a contradiction
+                }
+                auto backjump = analyze(confl);
+                cancel_until(backjump);
+                if (learnt.size() == 1) {
+                    enqueue(learnt[0], NO_REASON);
+                } else {
+                    auto index = add_clause(learnt.data(), (int)learnt.size());
+                    watch(index, true);
+                    enqueue(learnt[0], index);
+                }
+                continue;
+            }
+
+            if (conflicts_until_restart <= 0) {
+                cancel_until(0);
+                reduce_learnts();
+                conflicts_until_restart = restart_base * luby(++restarts);
+                continue;
+            }
+
+            auto v = pick_branch_var();
+            if (v == -1) {
+                break;  // success!
+            }
+            trail_lim.push_back((int)trail.size());
+            enqueue(polarity[v] ? pos(v) : neg(v), NO_REASON);
+        }
+
+        for (int cell = 0; cell < 81; ++cell) {
+            for (int d = 1; d <= 9; ++d) {
+                if (assigns[var_of(cell, d)] == 1) {
+                    grid[cell / 9][cell % 9] = d;
+                }
+            }
+        }
+        return true;
+    }
+};
+
+}  // namespace CDCL
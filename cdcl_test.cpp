@@ -0,0 +1,97 @@
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "sudoku.hpp"
+#include "test_check.hpp"
+
+// a solution is complete, breaks no rules, and keeps every given
+auto solves(const std::string& puzzle, SudokuBoard board) -> bool {
+    auto s = board.to_string();
+    for (size_t i = 0; i < puzzle.size(); ++i) {
+        if (puzzle[i] != '-' && puzzle[i] != s[i]) {
+            return false;
+        }
+    }
+    return s.find('-') == std::string::npos && !board.current_state_invalid();
+}
+
+int main() {
+    // Create an input filestream
+    std::ifstream sudokus("test_set.txt");
+
+    // Make sure the file is open
+    if (!sudokus.is_open()) throw std::runtime_error("Could not open file");
+
+    SudokuBoard driver;
+
+    std::string line;
+    // Read data, line by line
+    while (std::getline(sudokus, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+
+        driver.set_state(line);
+        bool success = driver.solve_cdcl();
+        check(success && solves(line, driver), line);
+    }
+
+    // the adversarial sudoku from main.cpp, which backtracking finds hardest
+    auto adversarial = std::string("--------------3-85--1-2-------5-7-----4---1---9-------5------73--2-1--------4---9");
+    driver.set_state(adversarial);
+    check(driver.solve_cdcl() && solves(adversarial, driver), "adversarial");
+
+    // repeated givens
+    driver.set_state(std::string("11"));
+    check(!driver.solve_cdcl(), "repeated digits are unsatisfiable");
+
+    // legal as given, but the last cell of the first row can only be a 9, which its column already has
+    driver.set_state(std::string("12345678-" "--------9"));
+    check(!driver.current_state_invalid() && !driver.solve_cdcl(), "overconstrained is unsatisfiable");
+
+    // an empty board has plenty of solutions
+    driver.clear();
+    check(driver.solve_cdcl() && solves("", driver), "empty board");
+
+    // the real limits only bite after thousands of conflicts, so a solver that restarts after a
+    // handful and keeps only a few learned clauses puts restarts and database reduction to work.
+    // every answer should agree with backtracking, on both satisfiable and unsatisfiable sudokus.
+    {
+        CDCL::Solver tiny(8, 4);
+        std::vector<std::string> hard = {
+            "8----------36------7--9-2---5---7-------457-----1---3---1----68--85---1--9----4--",
+            adversarial,
+            "--9------384---5------4-3-----1--27-2--3-4--5-48--6-----6-1------7---629-----5---",
+        };
+        // densely but legally filled boards, most of which turn out to have no solution
+        std::mt19937 rng(2022);
+        for (int t = 0; t < 300; ++t) {
+            SudokuBoard board;
+            int attempts = 60 + rng() % 60;
+            for (int k = 0; k < attempts; ++k) {
+                auto cell = board.at(rng() % 81);
+                int num = 1 + rng() % 9;
+                if (*cell == 0 && board.legal(cell, num)) {
+                    *cell = num;
+                }
+            }
+            hard.push_back(board.to_string());
+        }
+
+        long long reductions = 0;
+        int agreed = 0, unsatisfiable = 0;
+        for (const auto& sudoku : hard) {
+            auto expected = SudokuBoard(sudoku);
+            bool expected_success = expected.solve();
+            auto board = SudokuBoard(sudoku);
+            bool success = board.solve_cdcl(tiny);
+            reductions += tiny.reduction_count();
+            agreed += success == expected_success && (!success || solves(sudoku, board));
+            unsatisfiable += !expected_success;
+        }
+        check(agreed == (int)hard.size() && unsatisfiable > 0, "tiny limits agree with solve()");
+        check(reductions >= 5, "tiny limits reduce the learned clauses");
+    }
+    return test_status();
+}
@@ -4,6 +4,8 @@
 #include <string>
 #include <iostream>
 #include <cstddef>
+#include <cstdint>
+#include <fstream>
 
 static constexpr auto BLOCK_SIZE = 1024 * 1024;
 
@@ -25,4 +27,20 @@ auto fast_count_lines(const char* file_name) -> int {
         n += countlines(buff.data(), cc);
     }
     return n;
+}
+
+// FNV-1a hash of the first `lines` lines of a file, newlines included,
+// which identifies the input a sharded benchmark run was given.
+auto fast_fingerprint(const char* file_name, long long lines) -> uint64_t {
+    std::vector<char> buff(BLOCK_SIZE);
+    std::ifstream file_stream(file_name);
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    int cc;
+    while (lines > 0 && (cc = fileread(file_stream, buff.data(), buff.size()))) {
+        for (int i = 0; i < cc && lines > 0; ++i) {
+            hash = (hash ^ (unsigned char)buff[i]) * 0x100000001b3ULL;
+            lines -= buff[i] == '\n';
+        }
+    }
+    return hash;
 }
\ No newline at end of file
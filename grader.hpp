@@ -0,0 +1,594 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+
+namespace Grading {
+
+// The techniques the grader knows, in the order it tries them, which is also the order of
+// their difficulty. TRIAL_AND_ERROR means that none of the others was enough to finish.
+enum class Technique : int {
+    NONE,
+    HIDDEN_SINGLE,
+    NAKED_SINGLE,
+    LOCKED_CANDIDATES,
+    NAKED_PAIR,
+    X_WING,
+    HIDDEN_PAIR,
+    NAKED_TRIPLE,
+    SWORDFISH,
+    HIDDEN_TRIPLE,
+    XY_WING,
+    NAKED_QUAD,
+    JELLYFISH,
+    HIDDEN_QUAD,
+    SIMPLE_COLOURING,
+    XY_CHAIN,
+    TRIAL_AND_ERROR,
+};
+
+static constexpr int TECHNIQUE_COUNT = (int)Technique::TRIAL_AND_ERROR + 1;
+
+// ratings in tenths, on roughly the scale of Sudoku Explainer
+static constexpr std::array<int, TECHNIQUE_COUNT> RATINGS = {
+    0, 15, 23, 26, 30, 32, 34, 36, 38, 40, 42, 50, 52, 54, 56, 60, 100,
+};
+
+static constexpr std::array<std::string_view, TECHNIQUE_COUNT> NAMES = {
+    "none",
+    "hidden single",
+    "naked single",
+    "locked candidates",
+    "naked pair",
+    "x-wing",
+    "hidden pair",
+    "naked triple",
+    "swordfish",
+    "hidden triple",
+    "xy-wing",
+    "naked quad",
+    "jellyfish",
+    "hidden quad",
+    "simple colouring",
+    "xy-chain",
+    "trial and error",
+};
+
+inline auto name_of(Technique t) -> std::string_view {
+    return NAMES[(int)t];
+}
+
+struct Grade {
+    // the hardest technique needed to solve the sudoku
+    Technique hardest = Technique::NONE;
+    // the number of times a technique made progress
+    int steps = 0;
+    // false if the givens contradict each other
+    bool valid = true;
+
+    // the rating of the hardest technique, in tenths
+    auto score() const -> int {
+        return RATINGS[(int)hardest];
+    }
+};
+
+// cells are numbered 0-80, and units 0-26: the rows, then the columns, then the boxes.
+struct Tables {
+    std::array<std::array<int, 9>, 27> units;
+    std::array<std::array<int, 20>, 81> peers;
+};
+
+constexpr auto make_tables() -> Tables {
+    Tables t{};
+    for (int i = 0; i < 9; ++i) {
+        for (int j = 0; j < 9; ++j) {
+            t.units[i][j] = i * 9 + j;
+            t.units[9 + i][j] = j * 9 + i;
+            t.units[18 + i][j] = ((i / 3) * 3 + j / 3) * 9 + (i % 3) * 3 + j % 3;
+        }
+    }
+    for (int cell = 0; cell < 81; ++cell) {
+        int n = 0;
+        for (int other = 0; other < 81; ++other) {
+            bool same_row = other / 9 == cell / 9;
+            bool same_col = other % 9 == cell % 9;
+            bool same_box = (other / 27 == cell / 27) && ((other % 9) / 3 == (cell % 9) / 3);
+            if (other != cell && (same_row || same_col || same_box)) {
+                t.peers[cell][n++] = other;
+            }
+        }
+    }
+    return t;
+}
+
+inline constexpr Tables TABLES = make_tables();
+
+// Rates a sudoku by solving it the way a person would: candidates are pencilled in, and the
+// cheapest technique that makes progress is applied, starting again from the cheapest after
+// every step. The rating is that of the hardest technique needed. The naked single is the rule
+// fill_trivial_solutions() applies. Candidates are bitmasks (bit d for digit d) and everything
+// lives in fixed-size arrays, so grading never allocates, and takes microseconds per sudoku.
+class Grader {
+    using matrix = std::array<std::array<int, 9>, 9>;
+
+    std::array<int, 81> values;
+    std::array<uint16_t, 81> cands;
+
+    static constexpr uint16_t ALL = 0x3FE;
+
+    static constexpr auto bit(int d) -> uint16_t {
+        return (uint16_t)(1 << d);
+    }
+
+    static constexpr auto row_of(int cell) -> int {
+        return cell / 9;
+    }
+
+    static constexpr auto col_of(int cell) -> int {
+        return cell % 9;
+    }
+
+    static constexpr auto box_of(int cell) -> int {
+        return (cell / 27) * 3 + (cell % 9) / 3;
+    }
+
+    static constexpr auto sees(int a, int b) -> bool {
+        return a != b && (row_of(a) == row_of(b) || col_of(a) == col_of(b) || box_of(a) == box_of(b));
+    }
+
+    void place(int cell, int d) {
+        values[cell] = d;
+        cands[cell] = 0;
+        for (auto p : TABLES.peers[cell]) {
+            cands[p] &= ~bit(d);
+        }
+    }
+
+    auto eliminate(int cell, uint16_t mask) -> bool {
+        if (cands[cell] & mask) {
+            cands[cell] &= ~mask;
+            return true;
+        }
+        return false;
+    }
+
+    auto solved() const -> bool {
+        return std::ranges::all_of(values, std::identity{});
+    }
+
+    // an empty cell with no candidates, or a digit with nowhere left to go in some unit
+    auto contradiction() const -> bool {
+        for (int cell = 0; cell < 81; ++cell) {
+            if (!values[cell] && !cands[cell]) {
+                return true;
+            }
+        }
+        for (const auto& unit : TABLES.units) {
+            uint16_t covered = 0;
+            for (auto cell : unit) {
+                covered |= values[cell] ? bit(values[cell]) : cands[cell];
+            }
+            if (covered != ALL) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // calls visit(chosen, combined) for every choice of n of the first count masks whose union
+    // has exactly n bits set. chosen has bit i set for each mask picked.
+    template <typename F>
+    static void combinations(const std::array<uint16_t, 9>& masks, int count, int n, F&& visit,
+                             int start = 0, int depth = 0, uint16_t chosen = 0, uint16_t combined = 0) {
+        if (depth == n) {
+            visit(chosen, combined);
+            return;
+        }
+        for (int i = start; i <= count - (n - depth); ++i) {
+            uint16_t next = combined | masks[i];
+            if (std::popcount(next) > n) {
+                continue;
+            }
+            combinations(masks, count, n, visit, i + 1, depth + 1, (uint16_t)(chosen | bit(i)), next);
+        }
+    }
+
+    auto hidden_singles() -> bool {
+        bool progress = false;
+        for (const auto& unit : TABLES.units) {
+            for (int d = 1; d <= 9; ++d) {
+                int count = 0, where = -1;
+                for (auto cell : unit) {
+                    if (cands[cell] & bit(d)) {
+                        ++count;
+                        where = cell;
+                    }
+                }
+                if (count == 1) {
+                    place(where, d);
+                    progress = true;
+                }
+            }
+        }
+        return progress;
+    }
+
+    auto naked_singles() -> bool {
+        bool progress = false;
+        for (int cell = 0; cell < 81; ++cell) {
+            if (!values[cell] && std::popcount(cands[cell]) == 1) {
+                place(cell, std::countr_zero(cands[cell]));
+                progress = true;
+            }
+        }
+        return progress;
+    }
+
+    // a digit confined to one line within a box (pointing), or to one box within a line (claiming),
+    // can't go anywhere else along that line (or in that box).
+    auto locked_candidates() -> bool {
+        bool progress = false;
+        for (int u = 0; u < 27; ++u) {
+            const auto& unit = TABLES.units[u];
+            for (int d = 1; d <= 9; ++d) {
+                int rows = 0, cols = 0, boxes = 0, count = 0;
+                int first = -1;
+                for (auto cell : unit) {
+                    if (cands[cell] & bit(d)) {
+                        rows |= 1 << row_of(cell);
+                        cols |= 1 << col_of(cell);
+                        boxes |= 1 << box_of(cell);
+                        first = first == -1 ? cell : first;
+                        ++count;
+                    }
+                }
+                if (count < 2) {
+                    continue;
+                }
+                // the other unit the candidates are confined to, if any
+                int target = -1;
+                if (u >= 18) {
+                    if (std::popcount((unsigned)rows) == 1) target = row_of(first);
+                    else if (std::popcount((unsigned)cols) == 1) target = 9 + col_of(first);
+                } else if (std::popcount((unsigned)boxes) == 1) {
+                    target = 18 + box_of(first);
+                }
+                if (target == -1) {
+                    continue;
+                }
+                for (auto cell : TABLES.units[target]) {
+                    if (std::find(unit.begin(), unit.end(), cell) == unit.end()) {
+                        progress |= eliminate(cell, bit(d));
+                    }
+                }
+            }
+        }
+        return progress;
+    }
+
+    // n cells in a unit that only hold n digits between them take those digits from the rest of the unit
+    auto naked_subsets(int n) -> bool {
+        bool progress = false;
+        for (const auto& unit : TABLES.units) {
+            std::array<uint16_t, 9> masks;
+            std::array<int, 9> cells;
+            int count = 0, empty = 0;
+            for (auto cell : unit) {
+                if (values[cell]) continue;
+                ++empty;
+                if (std::popcount(cands[cell]) <= n) {
+                    cells[count] = cell;
+                    masks[count++] = cands[cell];
+                }
+            }
+            if (empty <= n) {
+                continue;
+            }
+            combinations(masks, count, n, [&](uint16_t chosen, uint16_t digits) {
+                for (auto cell : unit) {
+                    bool in_subset = false;
+                    for (int i = 0; i < count; ++i) {
+                        in_subset |= (chosen & bit(i)) && cells[i] == cell;
+                    }
+                    if (!in_subset && !values[cell]) {
+                        progress |= eliminate(cell, digits);
+                    }
+                }
+            });
+        }
+        return progress;
+    }
+
+    // n digits that can only go in the same n cells of a unit rule out every other digit in those cells
+    auto hidden_subsets(int n) -> bool {
+        bool progress = false;
+        for (const auto& unit : TABLES.units) {
+            std::array<uint16_t, 9> masks;
+            std::array<int, 9> digits;
+            int count = 0;
+            for (int d = 1; d <= 9; ++d) {
+                uint16_t positions = 0;
+                for (int i = 0; i < 9; ++i) {
+                    if (cands[unit[i]] & bit(d)) {
+                        positions |= bit(i);
+                    }
+                }
+                int size = std::popcount(positions);
+                if (size >= 2 && size <= n) {
+                    digits[count] = d;
+                    masks[count++] = positions;
+                }
+            }
+            combinations(masks, count, n, [&](uint16_t chosen, uint16_t positions) {
+                uint16_t keep = 0;
+                for (int i = 0; i < count; ++i) {
+                    if (chosen & bit(i)) keep |= bit(digits[i]);
+                }
+                for (int i = 0; i < 9; ++i) {
+                    if (positions & bit(i)) {
+                        progress |= eliminate(unit[i], ALL & ~keep);
+                    }
+                }
+            });
+        }
+        return progress;
+    }
+
+    // x-wing (n = 2), swordfish (3) and jellyfish (4): if a digit's places in n rows all fall in
+    // the same n columns, it must take one place in each of those columns from those rows,
+    // so it can't go anywhere else in the columns. the same holds with rows and columns swapped.
+    auto fish(int n) -> bool {
+        bool progress = false;
+        for (int d = 1; d <= 9; ++d) {
+            for (int base = 0; base < 2; ++base) {
+                // cell at (line, cross) in this orientation
+                auto at = [base](int line, int cross) { return base == 0 ? line * 9 + cross : cross * 9 + line; };
+                std::array<uint16_t, 9> masks;
+                std::array<int, 9> lines;
+                int count = 0;
+                for (int line = 0; line < 9; ++line) {
+                    uint16_t positions = 0;
+                    for (int cross = 0; cross < 9; ++cross) {
+                        if (cands[at(line, cross)] & bit(d)) {
+                            positions |= bit(cross);
+                        }
+                    }
+                    int size = std::popcount(positions);
+                    if (size >= 2 && size <= n) {
+                        lines[count] = line;
+                        masks[count++] = positions;
+                    }
+                }
+                combinations(masks, count, n, [&](uint16_t chosen, uint16_t crosses) {
+                    uint16_t base_lines = 0;
+                    for (int i = 0; i < count; ++i) {
+                        if (chosen & bit(i)) base_lines |= bit(lines[i]);
+                    }
+                    for (int cross = 0; cross < 9; ++cross) {
+                        if (!(crosses & bit(cross))) continue;
+                        for (int line = 0; line < 9; ++line) {
+                            if (!(base_lines & bit(line))) {
+                                progress |= eliminate(at(line, cross), bit(d));
+                            }
+                        }
+                    }
+                });
+            }
+        }
+        return progress;
+    }
+
+    // a bivalue pivot {x, y} seeing bivalue pincers {x, z} and {y, z} means one of the
+    // pincers is z, so z can't go in any cell that sees both of them.
+    auto xy_wings() -> bool {
+        bool progress = false;
+        for (int pivot = 0; pivot < 81; ++pivot) {
+            if (std::popcount(cands[pivot]) != 2) continue;
+            for (auto a : TABLES.peers[pivot]) {
+                uint16_t shared_a = cands[a] & cands[pivot];
+                if (std::popcount(cands[a]) != 2 || std::popcount(shared_a) != 1) continue;
+                uint16_t z = cands[a] & ~shared_a;
+                uint16_t want_b = (cands[pivot] & ~shared_a) | z;
+                for (auto b : TABLES.peers[pivot]) {
+                    if (b == a || cands[b] != want_b) continue;
+                    for (int cell = 0; cell < 81; ++cell) {
+                        if (cell != a && cell != b && sees(cell, a) && sees(cell, b)) {
+                            progress |= eliminate(cell, z);
+                        }
+                    }
+                }
+            }
+        }
+        return progress;
+    }
+
+    // for each digit, cells linked by being its only two places in some unit are alternately
+    // true and false, so they can be coloured in two colours, one of which is entirely true.
+    // a colour that sees itself is false (colour wrap), and a cell that sees both colours can't
+    // hold the digit (colour trap).
+    auto simple_colouring() -> bool {
+        bool progress = false;
+        for (int d = 1; d <= 9; ++d) {
+            std::array<std::array<int, 3>, 81> links;
+            std::array<int, 81> link_count = {};
+            for (const auto& unit : TABLES.units) {
+                int found = 0;
+                std::array<int, 2> pair = {-1, -1};
+                for (auto cell : unit) {
+                    if (cands[cell] & bit(d)) {
+                        if (found < 2) pair[found] = cell;
+                        ++found;
+                    }
+                }
+                if (found == 2) {
+                    links[pair[0]][link_count[pair[0]]++] = pair[1];
+                    links[pair[1]][link_count[pair[1]]++] = pair[0];
+                }
+            }
+
+            std::array<int, 81> colour;
+            colour.fill(-1);
+            for (int start = 0; start < 81; ++start) {
+                if (!link_count[start] || colour[start] != -1) continue;
+
+                // colour this chain breadth-first
+                std::array<int, 81> chain;
+                int size = 0;
+                colour[start] = 0;
+                chain[size++] = start;
+                for (int i = 0; i < size; ++i) {
+                    for (int k = 0; k < link_count[chain[i]]; ++k) {
+                        auto next = links[chain[i]][k];
+                        if (colour[next] == -1) {
+                            colour[next] = 1 - colour[chain[i]];
+                            chain[size++] = next;
+                        }
+                    }
+                }
+
+                // colour wrap
+                int wrong = -1;
+                for (int i = 0; i < size && wrong == -1; ++i) {
+                    for (int j = i + 1; j < size; ++j) {
+                        if (colour[chain[i]] == colour[chain[j]] && sees(chain[i], chain[j])) {
+                            wrong = colour[chain[i]];
+                            break;
+                        }
+                    }
+                }
+                if (wrong != -1) {
+                    for (int i = 0; i < size; ++i) {
+                        if (colour[chain[i]] == wrong) {
+                            progress |= eliminate(chain[i], bit(d));
+                        }
+                    }
+                    continue;
+                }
+
+                // colour trap
+                for (int cell = 0; cell < 81; ++cell) {
+                    if (!(cands[cell] & bit(d))) continue;
+                    bool in_chain = false, sees_0 = false, sees_1 = false;
+                    for (int i = 0; i < size; ++i) {
+                        in_chain |= chain[i] == cell;
+                        if (sees(cell, chain[i])) {
+                            (colour[chain[i]] ? sees_1 : sees_0) = true;
+                        }
+                    }
+                    if (!in_chain && sees_0 && sees_1) {
+                        progress |= eliminate(cell, bit(d));
+                    }
+                }
+            }
+        }
+        return progress;
+    }
+
+    // a chain of bivalue cells, each sharing a digit with the next, where assuming the first cell
+    // isn't x forces the last cell to be x. one end is x either way, so cells seeing both can't be.
+    auto xy_chains() -> bool {
+        bool progress = false;
+        for (int start = 0; start < 81; ++start) {
+            if (std::popcount(cands[start]) != 2) continue;
+            for (int x = 1; x <= 9; ++x) {
+                if (!(cands[start] & bit(x))) continue;
+
+                // breadth-first over (cell, the digit it is forced to take)
+                std::array<std::array<bool, 10>, 81> visited = {};
+                std::array<std::pair<int, int>, 810> queue;
+                int head = 0, tail = 0;
+                int forced = std::countr_zero((uint16_t)(cands[start] & ~bit(x)));
+                visited[start][forced] = true;
+                queue[tail++] = {start, forced};
+                while (head < tail) {
+                    auto [cell, value] = queue[head++];
+                    for (auto next : TABLES.peers[cell]) {
+                        if (next == start || std::popcount(cands[next]) != 2 || !(cands[next] & bit(value))) continue;
+                        int next_value = std::countr_zero((uint16_t)(cands[next] & ~bit(value)));
+                        if (visited[next][next_value]) continue;
+                        visited[next][next_value] = true;
+                        queue[tail++] = {next, next_value};
+                        if (next_value != x) continue;
+                        for (int cell2 = 0; cell2 < 81; ++cell2) {
+                            if (cell2 != start && cell2 != next && sees(cell2, start) && sees(cell2, next)) {
+                                progress |= eliminate(cell2, bit(x));
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        return progress;
+    }
+
+    auto apply(Technique t) -> bool {
+        using enum Technique;
+        switch (t) {
+            case HIDDEN_SINGLE: return hidden_singles();
+            case NAKED_SINGLE: return naked_singles();
+            case LOCKED_CANDIDATES: return locked_candidates();
+            case NAKED_PAIR: return naked_subsets(2);
+            case X_WING: return fish(2);
+            case HIDDEN_PAIR: return hidden_subsets(2);
+            case NAKED_TRIPLE: return naked_subsets(3);
+            case SWORDFISH: return fish(3);
+            case HIDDEN_TRIPLE: return hidden_subsets(3);
+            case XY_WING: return xy_wings();
+            case NAKED_QUAD: return naked_subsets(4);
+            case JELLYFISH: return fish(4);
+            case HIDDEN_QUAD: return hidden_subsets(4);
+            case SIMPLE_COLOURING: return simple_colouring();
+            case XY_CHAIN: return xy_chains();
+            default: return false;
+        }
+    }
+
+   public:
+    auto grade(const matrix& grid) -> Grade {
+        Grade result;
+        values.fill(0);
+        cands.fill(ALL);
+        for (int cell = 0; cell < 81; ++cell) {
+            auto d = grid[cell / 9][cell % 9];
+            if (!d) continue;
+            if (!(cands[cell] & bit(d))) {
+                result.valid = false;  // a peer already has this digit
+                return result;
+            }
+            place(cell, d);
+        }
+
+        while (!solved()) {
+            if (contradiction()) {
+                result.valid = false;
+                return result;
+            }
+            auto used = Technique::NONE;
+            for (int t = (int)Technique::HIDDEN_SINGLE; t < (int)Technique::TRIAL_AND_ERROR; ++t) {
+                if (apply((Technique)t)) {
+                    used = (Technique)t;
+                    break;
+                }
+            }
+            if (used == Technique::NONE) {
+                // none of our techniques will finish this one
+                result.hardest = Technique::TRIAL_AND_ERROR;
+                return result;
+            }
+            result.hardest = std::max(result.hardest, used);
+            ++result.steps;
+        }
+        return result;
+    }
+
+    // the digits placed by the last call to grade(), with 0 for cells left empty
+    auto placed(int cell) const -> int {
+        return values[cell];
+    }
+};
+
+}  // namespace Grading
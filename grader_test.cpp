@@ -0,0 +1,98 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sudoku.hpp"
+#include "test_check.hpp"
+
+// every digit the grader placed agrees with the answer
+auto sound(Grading::Grader& grader, const std::string& answer) -> bool {
+    for (int i = 0; i < 81; ++i) {
+        if (grader.placed(i) && grader.placed(i) != answer[i] - '0') {
+            return false;
+        }
+    }
+    return true;
+}
+
+auto grid_of(const std::string& sudoku) -> std::array<std::array<int, 9>, 9> {
+    std::array<std::array<int, 9>, 9> grid;
+    for (int i = 0; i < 81; ++i) {
+        grid[i / 9][i % 9] = i < (int)sudoku.size() ? SudokuBoard::char_to_int(sudoku[i]) : 0;
+    }
+    return grid;
+}
+
+int main() {
+    // Create an input filestream
+    std::ifstream sudokus("test_set.txt");
+    std::ifstream answers("answer_set.txt");
+
+    // Make sure the file is open
+    if (!sudokus.is_open()) throw std::runtime_error("Could not open file");
+
+    Grading::Grader grader;
+
+    std::string line;
+    std::string answer;
+    // techniques only ever place digits that are in every solution, so they must match the answer
+    while (std::getline(sudokus, line)) {
+        std::getline(answers, answer);
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (!answer.empty() && answer.back() == '\r') answer.pop_back();
+
+        auto grade = grader.grade(grid_of(line));
+        check(grade.valid && grade.hardest != Grading::Technique::NONE && sound(grader, answer), line);
+    }
+
+    // minimal sudokus, each of which needs the technique it is listed with
+    std::vector<std::pair<std::string, Grading::Technique>> rated = {
+        { "-8-----3-34----5-2---94--6----698---47-----89------1----2-7-----6-23---7-5-----1-", Grading::Technique::LOCKED_CANDIDATES },
+        { "-738---1---------7-6--2----9-1-8-5--4--2---81---73-----------------6--5---5--49-", Grading::Technique::NAKED_PAIR },
+        { "-812-5---6-2-1---------6------6-3--9-94------3----2-74-3-4----62-7-----1---83----", Grading::Technique::X_WING },
+        { "---8--9--5-4-6--37-7------44-5238-------------82-------9-----4-----83-9---8--5-23", Grading::Technique::HIDDEN_PAIR },
+        { "-6-9-38-45---2-------1--23-456-------8---5-----7----8-74----------8---96-9-2----1", Grading::Technique::NAKED_TRIPLE },
+        { "-65----1-7--65----9-4--7------96------618-75------2---2-------4-1-----9--5-24----", Grading::Technique::SWORDFISH },
+        { "--3--2--11-6--95----9---------3--6-9-7-5--8------1--7----4--1--2-------6---25-4-3", Grading::Technique::HIDDEN_TRIPLE },
+        { "----4--8---2---1-6--1------1-43-8-7--7---5----5--29-6-43-9-----7-----69------7--3", Grading::Technique::XY_WING },
+        { "---7-----95--8-63---7-31--8--6--23-----8----6---4-7-1-3-5---9--7------5---41--8--", Grading::Technique::SIMPLE_COLOURING },
+        { "--9-2-5-------3-412----5--6----3---2---9-16--7---4--8-17-------6----2-1-----7---4", Grading::Technique::XY_CHAIN },
+    };
+    for (const auto& [sudoku, expected] : rated) {
+        auto board = SudokuBoard(sudoku);
+        board.solve_cdcl();
+        auto grade = grader.grade(grid_of(sudoku));
+        bool finished = true;
+        for (int i = 0; i < 81; ++i) {
+            finished = finished && grader.placed(i);
+        }
+        check(grade.valid && grade.hardest == expected && finished && sound(grader, board.to_string()),
+              sudoku + " needs " + std::string(Grading::name_of(expected)));
+    }
+
+    // grading is deterministic, and doesn't depend on what was graded before
+    {
+        auto first = Grading::Grader().grade(grid_of(rated.back().first));
+        auto again = grader.grade(grid_of(rated.back().first));
+        check(first.hardest == again.hardest && first.steps == again.steps, "deterministic");
+    }
+
+    // nothing to do for a solved sudoku
+    {
+        std::ifstream solved("answer_set.txt");
+        std::getline(solved, answer);
+        if (!answer.empty() && answer.back() == '\r') answer.pop_back();
+        auto grade = SudokuBoard(answer).grade();
+        check(grade.valid && grade.hardest == Grading::Technique::NONE && grade.score() == 0, "solved sudoku");
+    }
+
+    // an empty board has far too many solutions for logic alone
+    check(SudokuBoard().grade().hardest == Grading::Technique::TRIAL_AND_ERROR, "empty board");
+
+    // repeated givens, and givens that leave a cell with no candidates
+    check(!SudokuBoard(std::string("11")).grade().valid, "repeated digits are invalid");
+    check(!SudokuBoard(std::string("12345678-" "--------9")).grade().valid, "overconstrained is invalid");
+    return test_status();
+}
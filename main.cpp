@@ -3,6 +3,7 @@
 #include <chrono>
 #include <iostream>
 #include <string>
+#include <string_view>
 
 #include "sudoku.hpp"
 
@@ -12,14 +13,63 @@
 // evil: "--9------384---5------4-3-----1--27-2--3-4--5-48--6-----6-1------7---629-----5---"
 // adversarial: "--------------3-85--1-2-------5-7-----4---1---9-------5------73--2-1--------4---9"
 
+// writes each solution as a line of digits the moment it is found, so that
+// under-constrained sudokus can be piped somewhere without ever being held in memory.
+// stdout carries only the solutions, the summary goes to stderr.
+auto stream_solutions(SudokuBoard& b) -> int {
+    if (b.current_state_invalid()) {
+        std::cerr << "input sudoku invalid (given problem has repeated digits in rows, columns, or squares).\n";
+        return 0;
+    }
+
+    auto start = std::chrono::system_clock::now();
+
+    // each solution is written into the same line buffer
+    std::array<char, 82> line;
+    line.back() = '\n';
+
+    long long count = 0;
+    for (const auto& solution : b.solutions()) {
+        solution.write_string(std::span<char, 81>(line.data(), 81));
+        std::cout.write(line.data(), line.size());
+        ++count;
+    }
+    std::cout.flush();
+
+    auto end = std::chrono::system_clock::now();
+    auto time = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+    std::cerr << count << " solutions found in " << time << "μs.\n";
+    return 0;
+}
+
 auto main(int argc, char *argv[]) -> int {
+    // "--all" streams every solution instead of solving once,
+    // "--cdcl" solves with the clause-learning engine instead of backtracking,
+    // "--grade" also rates the sudoku's difficulty
+    int arg = 1;
+    bool enumerate_all = false;
+    bool use_cdcl = false;
+    bool show_grade = false;
+    for (; arg < argc; ++arg) {
+        auto option = std::string_view(argv[arg]);
+        if (option == "--all") {
+            enumerate_all = true;
+        } else if (option == "--cdcl") {
+            use_cdcl = true;
+        } else if (option == "--grade") {
+            show_grade = true;
+        } else {
+            break;
+        }
+    }
     // check if we haven't been given any arguments
-    if (argc <= 1) {
+    if (argc <= arg) {
         std::cout << "no input string provided.\n";
         return 0;
     }
     // create a std::string from which the board is initialised
-    auto in = std::string(argv[1]);
+    auto in = std::string(argv[arg]);
     // verify that all the characters in the string are valid, exit early if not
     if (!SudokuBoard::is_string_valid(in)) {
         std::cout << "input string invalid (you may only use digits and dashes in your input).\n";
@@ -28,6 +78,10 @@ auto main(int argc, char *argv[]) -> int {
     // object is created.
     auto b = SudokuBoard(in);
 
+    if (enumerate_all) {
+        return stream_solutions(b);
+    }
+
     // show the user their initial board, to confirm to
     // them that they have entered the correct CLI string
     std::cout << "Your sudoku:";
@@ -39,12 +93,18 @@ auto main(int argc, char *argv[]) -> int {
         return 0;
     }
 
+    if (show_grade) {
+        auto grade = b.grade();
+        std::cout << "difficulty: " << grade.score() / 10 << "." << grade.score() % 10
+                  << " (" << Grading::name_of(grade.hardest) << ")\n";
+    }
+
     // a timer that tracks how long we take to solve the problem
     auto start = std::chrono::system_clock::now();
 
-    // solve() both mutates the board to a solved state,
-    // and returns a flag that indicates if it was successful
-    bool success = b.solve();
+    // solve() and solve_cdcl() both mutate the board to a solved state,
+    // and return a flag that indicates if it was successful
+    bool success = use_cdcl ? b.solve_cdcl() : b.solve();
 
     // if the solve was unsuccessful, then the given sudoku was bad, and we exit early
     if (!success) {
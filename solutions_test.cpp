@@ -0,0 +1,86 @@
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <string>
+
+#include "sudoku.hpp"
+#include "test_check.hpp"
+
+// a complete grid that breaks no rules is a solution
+auto is_solution(SudokuBoard board) -> bool {
+    auto s = board.to_string();
+    return s.find('-') == std::string::npos && !board.current_state_invalid();
+}
+
+int main() {
+    // Create an input filestream
+    std::ifstream sudokus("test_set.txt");
+    std::ifstream answers("answer_set.txt");
+
+    // Make sure the file is open
+    if (!sudokus.is_open()) throw std::runtime_error("Could not open file");
+
+    std::string line;
+    std::string answer;
+    // the expected answer to every sudoku in the test set should be among its solutions
+    while (std::getline(sudokus, line)) {
+        std::getline(answers, answer);
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (!answer.empty() && answer.back() == '\r') answer.pop_back();
+
+        auto board = SudokuBoard(line);
+        bool all_valid = true;
+        bool found_answer = false;
+        for (const auto& solution : board.solutions()) {
+            all_valid = all_valid && is_solution(solution);
+            found_answer = found_answer || solution.to_string() == answer;
+        }
+        check(all_valid && found_answer, line);
+    }
+
+    // "evil" from main.cpp has 17 solutions, all of which should be distinct and valid
+    {
+        auto board = SudokuBoard(std::string("--9------384---5------4-3-----1--27-2--3-4--5-48--6-----6-1------7---629-----5---"));
+        auto before = board.to_string();
+        std::set<std::string> found;
+        bool all_valid = true;
+        for (const auto& solution : board.solutions()) {
+            all_valid = all_valid && is_solution(solution);
+            found.insert(solution.to_string());
+        }
+        check(found.size() == 17 && all_valid, "evil has 17 solutions");
+        check(board.to_string() == before, "enumeration leaves the board untouched");
+    }
+
+    // an empty board has far too many solutions to list, so only take the first few thousand
+    {
+        auto enumerator = SudokuBoard().solutions();
+        std::set<std::string> found;
+        bool all_valid = true;
+        while (found.size() < 5000 && enumerator.next()) {
+            all_valid = all_valid && is_solution(enumerator.current());
+            found.insert(enumerator.current().to_string());
+        }
+        check(found.size() == 5000 && all_valid && !enumerator.done(), "empty board is enumerated lazily");
+    }
+
+    // an iterator that was never attached to an enumerator is already at the end
+    check(SolutionEnumerator::Iterator() == std::default_sentinel, "default iterator is at the end");
+
+    // repeated digits mean there is nothing to enumerate
+    {
+        auto enumerator = SudokuBoard(std::string("11")).solutions();
+        check(!enumerator.next() && enumerator.done(), "invalid board has no solutions");
+    }
+
+    // an already-solved board is its own single solution
+    {
+        std::ifstream solved("answer_set.txt");
+        std::getline(solved, answer);
+        if (!answer.empty() && answer.back() == '\r') answer.pop_back();
+        auto enumerator = SudokuBoard(answer).solutions();
+        bool first = enumerator.next() && enumerator.current().to_string() == answer;
+        check(first && !enumerator.next(), "solved board has one solution");
+    }
+    return test_status();
+}
@@ -4,17 +4,21 @@
 #include <chrono>
 #include <iostream>
 #include <iterator>
-#include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <ranges>
 #include <span>
 
+#include "cdcl.hpp"
 #include "dlxnode.hpp"
+#include "grader.hpp"
 #include "sudokuiterators.hpp"
 
 using enum RangeType;
 
+class SolutionEnumerator;
+
 template <typename Range>
 concept InputCharRange = std::ranges::input_range<Range> && std::convertible_to<char, std::ranges::range_value_t<Range>>;
 
@@ -71,10 +75,16 @@ class SudokuBoard {
             char_to_int);
     }
 
-    auto to_string() -> std::string {
+    // writes the board as a line of digits and dashes into a caller-provided buffer
+    void write_string(std::span<char, 81> out) const {
         using namespace std::ranges;
-        auto char_range = state | views::join | views::transform(int_to_char);
-        return std::string(char_range.begin(), char_range.end());
+        transform(state | views::join, out.begin(), int_to_char);
+    }
+
+    auto to_string() const -> std::string {
+        std::string out(81, '-');
+        write_string(std::span<char, 81>(out.data(), 81));
+        return out;
     }
 
     template <InputCharRange CharContainer>
@@ -85,32 +95,41 @@ class SudokuBoard {
         return std::ranges::all_of(str, valid);
     }
 
-    void show() const {
-        static const std::string divider = "├───────┼───────┼───────┤\n";
-        static const std::string top = "┌───────┬───────┬───────┐\n";
-        static const std::string bottom = "└───────┴───────┴───────┘\n";
-        static const std::string bar = "│ ";
-        static const std::string ascii_divider = "|-------|-------|-------|\n";
-        static const std::string ascii_top = "|-------|-------|-------|\n";
-        static const std::string ascii_bottom = "|-------|-------|-------|\n";
-        static const std::string ascii_bar = "| ";
-
-        std::stringstream sb;
-
-        sb << "\n";
-        sb << top;
+    // an upper bound on the bytes render() writes
+    static constexpr size_t RENDER_SIZE = 1024;
+
+    // draws the board into a caller-provided buffer, returning the number of bytes written
+    auto render(std::span<char, RENDER_SIZE> out) const -> size_t {
+        static constexpr std::string_view divider = "├───────┼───────┼───────┤\n";
+        static constexpr std::string_view top = "┌───────┬───────┬───────┐\n";
+        static constexpr std::string_view bottom = "└───────┴───────┴───────┘\n";
+        static constexpr std::string_view bar = "│ ";
+
+        auto sb = out.begin();
+        auto put = [&sb](std::string_view s) { sb = std::copy(s.begin(), s.end(), sb); };
+
+        put("\n");
+        put(top);
         for (size_t y = 0; y < 9; y++) {
-            sb << bar;
+            put(bar);
             for (size_t x = 0; x < 9; x++) {
-                sb << symbols[ state[y][x] ] << " ";
-                if (x % 3 == 2 && x != 8) sb << bar;
+                *sb++ = symbols[ state[y][x] ];
+                *sb++ = ' ';
+                if (x % 3 == 2 && x != 8) put(bar);
             }
-            sb << bar << "\n";
-            if (y % 3 == 2 && y != 8) sb << divider;
+            put(bar);
+            put("\n");
+            if (y % 3 == 2 && y != 8) put(divider);
         }
-        sb << bottom;
+        put(bottom);
 
-        std::cout << sb.str();
+        return sb - out.begin();
+    }
+
+    void show() const {
+        std::array<char, RENDER_SIZE> buffer;
+        auto size = render(buffer);
+        std::cout.write(buffer.data(), size);
     }
 
     auto transpose() {
@@ -121,6 +140,10 @@ class SudokuBoard {
         return state[x / 9][x % 9];
     }
 
+    auto at(int x) -> Iterator2D<GLOBAL> {
+        return Iterator2D<GLOBAL>::begin(state, x);
+    }
+
     auto current_state_invalid() -> bool {
         for (
             auto val = begin(),
@@ -190,7 +213,9 @@ class SudokuBoard {
         return false;  // this triggers backtracking
     }
 
-    auto solve_dfs() -> bool {
+    // whether more of the givens are in the bottom half of the board than the top.
+    // the search fills cells in row order, so it runs much faster over the transposed board.
+    auto bottom_heavy() -> bool {
         auto start_it = begin();
         auto middle_it = begin();
         std::advance(middle_it, 41);
@@ -199,7 +224,11 @@ class SudokuBoard {
         auto t_count = std::count_if(start_it, middle_it, std::identity{});
         auto b_count = std::count_if(middle_it, end_it, std::identity{});
 
-        bool transposed = b_count > t_count;
+        return b_count > t_count;
+    }
+
+    auto solve_dfs() -> bool {
+        bool transposed = bottom_heavy();
         if (transposed) {
             transpose();
         }
@@ -244,4 +273,197 @@ class SudokuBoard {
         // drop into dfs
         return solve_dfs();
     }
-};
\ No newline at end of file
+
+    // the clause-learning engine, for sudokus built to defeat backtracking.
+    // the solver's clause database is built once per thread and reused.
+    auto solve_cdcl() -> bool {
+        static thread_local CDCL::Solver solver;
+        return solve_cdcl(solver);
+    }
+
+    auto solve_cdcl(CDCL::Solver& solver) -> bool {
+        return solver.solve(state);
+    }
+
+    // rates how hard the sudoku is for a person, by the techniques needed to solve it
+    auto grade() const -> Grading::Grade {
+        Grading::Grader grader;
+        return grader.grade(state);
+    }
+
+    // lazily walks every solution, leaving this board untouched.
+    auto solutions() const -> SolutionEnumerator;
+};
+
+// resumable version of search_dfs(), which yields every solution instead of stopping at the first.
+// the recursion is replaced by an explicit stack of (empty cell, last digit tried) pairs, so the
+// search can return after filling the last empty cell and pick up exactly where it left off on
+// the next call. only one board is searched, so a sudoku with millions of solutions costs no more
+// memory than one with a single solution. like solve_dfs(), bottom-heavy boards are searched
+// transposed, and each solution is transposed back into `solution` before it is handed out.
+class SolutionEnumerator {
+    SudokuBoard board;
+    SudokuBoard solution;
+    bool transposed = false;
+    std::array<int, 81> empties;
+    std::array<int, 81> tried;
+    int empty_count = 0;
+    int depth = 0;
+    bool started = false;
+    bool exhausted = false;
+
+   public:
+    // single-pass input iterator, so that solutions can be consumed with a range-for
+    // or any std::ranges algorithm. incrementing it resumes the search.
+    class Iterator {
+        SolutionEnumerator* source = nullptr;
+
+       public:
+        using iterator_category = std::input_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = SudokuBoard;
+
+        Iterator() = default;
+        Iterator(SolutionEnumerator* s) : source(s) {}
+
+        auto operator*() const -> const SudokuBoard& {
+            return source->current();
+        }
+
+        auto operator++() -> Iterator& {
+            source->next();
+            return *this;
+        }
+
+        void operator++(int) {
+            ++(*this);
+        }
+
+        friend bool operator==(const Iterator& it, std::default_sentinel_t) {
+            // a default-constructed iterator points at nothing, so it is already at the end
+            return !it.source || it.source->done();
+        }
+    };
+
+    SolutionEnumerator(const SudokuBoard& start) : board(start) {
+        transposed = board.bottom_heavy();
+        if (transposed) {
+            board.transpose();
+        }
+        tried.fill(0);
+        for (int i = 0; i < 81; ++i) {
+            if (board.get_num_at_position(i) == 0) {
+                empties[empty_count++] = i;
+            }
+        }
+        // a board that breaks the rules as given has nothing to enumerate
+        exhausted = board.current_state_invalid();
+    }
+
+    // advances to the next solution, returning false once there are none left.
+    // after a successful call, current() holds the solved board.
+    auto next() -> bool {
+        if (exhausted) {
+            return false;
+        }
+        // we only ever stop with every empty cell filled, so resuming
+        // means retrying the deepest cell with its next digit.
+        if (started) {
+            --depth;
+        }
+        started = true;
+        while (depth >= 0) {
+            if (depth == empty_count) {
+                if (transposed) {
+                    solution = board;
+                    solution.transpose();
+                }
+                return true;  // success!
+            }
+            auto cell = board.at(empties[depth]);
+            *cell = 0;
+            int num = tried[depth] + 1;
+            while (num <= 9 && !board.legal(cell, num)) {
+                ++num;
+            }
+            if (num <= 9) {
+                *cell = num;
+                tried[depth] = num;
+                ++depth;
+            } else {
+                // out of digits for this cell, so backtrack
+                tried[depth] = 0;
+                --depth;
+            }
+        }
+        exhausted = true;
+        return false;
+    }
+
+    auto current() const -> const SudokuBoard& {
+        return transposed ? solution : board;
+    }
+
+    auto done() const -> bool {
+        return exhausted;
+    }
+
+    auto begin() -> Iterator {
+        if (!started) {
+            next();
+        }
+        return Iterator(this);
+    }
+
+    auto end() -> std::default_sentinel_t {
+        return std::default_sentinel;
+    }
+};
+
+// everything needed to solve a stream of sudokus, allocated once and reused for each of them.
+// keep one per thread: after the first few puzzles have grown the clause-learning buffers to
+// their working size, loading, solving and writing out a sudoku does no heap allocation at all.
+class SolverContext {
+    SudokuBoard board;
+    CDCL::Solver cdcl;
+
+   public:
+    // replaces whatever was left over from the previous sudoku
+    template <InputCharRange CharContainer>
+    void load(const CharContainer& in) {
+        board.set_state(in);
+    }
+
+    auto solve() -> bool {
+        return board.solve();
+    }
+
+    auto solve_cdcl() -> bool {
+        return board.solve_cdcl(cdcl);
+    }
+
+    // loads, solves and writes the result into out in one go
+    template <InputCharRange CharContainer>
+    auto solve(const CharContainer& in, std::span<char, 81> out, bool use_cdcl = false) -> bool {
+        load(in);
+        auto success = use_cdcl ? solve_cdcl() : solve();
+        write_string(out);
+        return success;
+    }
+
+    void write_string(std::span<char, 81> out) const {
+        board.write_string(out);
+    }
+
+    auto render(std::span<char, SudokuBoard::RENDER_SIZE> out) const -> size_t {
+        return board.render(out);
+    }
+
+    auto current() -> SudokuBoard& {
+        return board;
+    }
+};
+
+inline auto SudokuBoard::solutions() const -> SolutionEnumerator {
+    return SolutionEnumerator(*this);
+}
\ No newline at end of file
@@ -1,86 +1,125 @@
+#include <array>
 #include <cassert>
+#include <cstdio>
 #include <fstream>
-#include <iomanip>
 #include <iostream>
-#include <sstream>
+#include <limits>
 #include <string>
-#include <vector>
+#include <string_view>
 
 #include "sudoku.hpp"
 #include "fastfile.hpp"
+#include "benchresult.hpp"
 
 const char* BENCHMARK_FILENAME = "benchmark_set.txt";
-constexpr auto SUDOKU_LINE_LEN = 81;
 
+// usage: ./bench [count] [--cdcl] [--grade] [--shard i/N] [--out partial.txt]
+//
+// --grade rates each sudoku by the hardest technique a person would need (outside the timed
+// section), and breaks the report down into those difficulty buckets.
+//
+// --shard i/N solves only the i-th of N equal runs of records among the first [count] sudokus
+// in the file (zero-based), and --out writes this run's partial result to a file, so that one
+// benchmark can be spread over several processes or machines. ./merge combines the partial
+// results into the report a single run over all the sudokus would have printed.
 int main(int argc, char* argv[]) {
-    int max_sudokus_processed = fast_count_lines(BENCHMARK_FILENAME) - 1;
-    
-    if (argc > 1) {
-        max_sudokus_processed = atoi(argv[1]);
+    long long max_sudokus_processed = fast_count_lines(BENCHMARK_FILENAME);
+    const char* out_filename = nullptr;
+    BenchResult result;
+
+    for (int arg = 1; arg < argc; ++arg) {
+        auto option = std::string_view(argv[arg]);
+        if (option == "--cdcl") {
+            result.use_cdcl = true;
+        } else if (option == "--grade") {
+            result.graded = true;
+        } else if (option == "--shard" && arg + 1 < argc) {
+            if (sscanf(argv[++arg], "%d/%d", &result.shard, &result.shard_count) != 2 ||
+                result.shard_count < 1 || result.shard < 0 || result.shard >= result.shard_count) {
+                std::cout << "shard must be given as i/N, with 0 <= i < N.\n";
+                return 1;
+            }
+        } else if (option == "--out" && arg + 1 < argc) {
+            out_filename = argv[++arg];
+        } else {
+            max_sudokus_processed = std::min(max_sudokus_processed, atoll(argv[arg]));
+        }
     }
 
     assert(max_sudokus_processed > 0);
 
+    // this shard's records are [first, last) of the first max_sudokus_processed
+    long long first = max_sudokus_processed * result.shard / result.shard_count;
+    long long last = max_sudokus_processed * (result.shard + 1) / result.shard_count;
+    result.first = first;
+    result.last = last;
+    result.records = max_sudokus_processed;
+    result.fingerprint = fast_fingerprint(BENCHMARK_FILENAME, max_sudokus_processed);
+
     // Create an input filestream
     std::ifstream sudokus(BENCHMARK_FILENAME);
 
     // Make sure the file is open
     if (!sudokus.is_open()) throw std::runtime_error("Could not open file");
 
-    SudokuBoard driver;
+    // skip the records that belong to earlier shards
+    for (long long i = 0; i < first; ++i) {
+        sudokus.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
 
-    std::string easiest_sudoku, hardest_sudoku;
-    long long min_time = std::numeric_limits<long long>::max(), max_time = 0;
+    SolverContext context;
 
-    int count = 0;
+    // lines are read into a reused string and solutions into a fixed buffer,
+    // so that the timed loop doesn't allocate once it has warmed up.
+    std::array<char, SUDOKU_LINE_LEN> solution;
     std::string line;
 
     // time the whole execution
     auto global_start = std::chrono::system_clock::now();
 
     // Read data, line by line
-    while (std::getline(sudokus, line)) {
-        printf("%d out of %d\r", count, max_sudokus_processed);
+    for (long long index = first; index < last && std::getline(sudokus, line); ++index) {
+        printf("%lld out of %lld\r", index - first, last - first);
         fflush(stdout);
 
         std::replace(line.begin(), line.end(), '.', '-');
-        driver.set_state(line);
+
+        // parsing, grading and writing out the solution all happen outside the timed section
+        context.load(line);
+
+        Grading::Grade grade;
+        if (result.graded) {
+            grade = context.current().grade();
+        }
 
         auto start = std::chrono::system_clock::now();
-        driver.solve();
+        bool success = result.use_cdcl ? context.solve_cdcl() : context.solve();
         auto end = std::chrono::system_clock::now();
 
-        auto time = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        context.write_string(solution);
 
-        if (time > max_time) {
-            max_time = time;
-            hardest_sudoku = line.substr(0, SUDOKU_LINE_LEN);
-        }
+        auto time = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
 
-        if (time < min_time) {
-            min_time = time;
-            easiest_sudoku = line.substr(0, SUDOKU_LINE_LEN);
+        result.add(index, std::string_view(line).substr(0, SUDOKU_LINE_LEN), time, success);
+        if (result.graded) {
+            result.add_difficulty(grade, time);
         }
-
-        // std::cout << std::right << std::setprecision(2) << ((double)count / (double)max_sudokus_processed * 100.0) << "% done.\r";
-        // std::cout << line << " solved in " << std::right << std::setw(6) << time << "μs." << std::endl;
-        if (count == max_sudokus_processed) break;
-        count++;
     }
-    printf("%d out of %d\n", count, max_sudokus_processed);
+    printf("%lld out of %lld\n", result.total(), last - first);
 
     auto global_end = std::chrono::system_clock::now();
 
-    auto global_time = std::chrono::duration_cast<std::chrono::microseconds>(global_end - global_start).count();
-
-    std::cout << std::endl
-              << "hardest sudoku "
-              << hardest_sudoku << " took "
-              << std::right << std::setw(6) << max_time << "μs." << std::endl
-              << "easiest sudoku "
-              << easiest_sudoku << " took "
-              << std::right << std::setw(6) << min_time << "μs." << std::endl
-              << "total time: " 
-              << std::right << std::setw(6) << global_time << "μs." << std::endl;
+    result.wall_time = std::chrono::duration_cast<std::chrono::microseconds>(global_end - global_start).count();
+
+    if (out_filename) {
+        std::ofstream out(out_filename);
+        result.write(out);
+        if (!out) {
+            std::cout << "could not write partial result to " << out_filename << ".\n";
+            return 1;
+        }
+    }
+
+    result.report(std::cout);
     return 0;
 }
@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "sudoku.hpp"
+
+// usage: ./grade sudokus.txt [--threads n]
+//
+// rates every sudoku in the file, one per line, using '-' or '.' for empty cells. each line of
+// output is the sudoku, its score and the hardest technique it needed, in the order of the input.
+// lines holding anything else, or whose givens contradict each other, are printed as invalid.
+// the file is read in blocks of BLOCK_SIZE sudokus, each block split between threads in contiguous
+// runs (one thread per core by default) and printed before the next is read, so memory use stays
+// fixed however large the file is.
+constexpr size_t BLOCK_SIZE = 4096;
+
+int main(int argc, char* argv[]) {
+    const char* filename = nullptr;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (int arg = 1; arg < argc; ++arg) {
+        auto option = std::string_view(argv[arg]);
+        if (option == "--threads" && arg + 1 < argc) {
+            threads = std::max(1, atoi(argv[++arg]));
+        } else {
+            filename = argv[arg];
+        }
+    }
+
+    if (!filename) {
+        std::cout << "no input file provided.\n";
+        return 1;
+    }
+
+    // Create an input filestream
+    std::ifstream sudokus(filename);
+
+    // Make sure the file is open
+    if (!sudokus.is_open()) throw std::runtime_error("Could not open file");
+
+    // every block reuses the same lines, grades and boards
+    std::vector<std::string> lines(BLOCK_SIZE);
+    std::vector<Grading::Grade> grades(BLOCK_SIZE);
+    std::vector<SudokuBoard> boards(threads);
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+
+    std::array<long long, Grading::TECHNIQUE_COUNT> counts = {};
+    long long invalid = 0;
+    long long total = 0;
+    long long time = 0;
+
+    while (true) {
+        size_t count = 0;
+        while (count < BLOCK_SIZE && std::getline(sudokus, lines[count])) {
+            auto& line = lines[count++];
+            line.resize(std::min<size_t>(line.size(), 81));
+            std::replace(line.begin(), line.end(), '.', '-');
+        }
+        if (count == 0) break;
+
+        auto start = std::chrono::system_clock::now();
+
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                auto first = count * t / threads;
+                auto last = count * (t + 1) / threads;
+                for (auto i = first; i < last; ++i) {
+                    // corpora aren't trusted: anything but digits and blanks is invalid, and never graded
+                    if (!SudokuBoard::is_string_valid(lines[i])) {
+                        grades[i] = Grading::Grade();
+                        grades[i].valid = false;
+                        continue;
+                    }
+                    boards[t].set_state(lines[i]);
+                    grades[i] = boards[t].grade();
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        workers.clear();
+
+        auto end = std::chrono::system_clock::now();
+        time += std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+        for (size_t i = 0; i < count; ++i) {
+            const auto& grade = grades[i];
+            if (!grade.valid) {
+                std::cout << lines[i] << " invalid\n";
+                ++invalid;
+                continue;
+            }
+            std::cout << lines[i] << " " << grade.score() / 10 << "." << grade.score() % 10
+                      << " " << Grading::name_of(grade.hardest) << "\n";
+            ++counts[(int)grade.hardest];
+        }
+        total += count;
+    }
+
+    // the summary goes to stderr, so that stdout can be piped elsewhere
+    for (int t = 0; t < Grading::TECHNIQUE_COUNT; ++t) {
+        if (counts[t]) {
+            std::cerr << Grading::name_of((Grading::Technique)t) << ": " << counts[t] << "\n";
+        }
+    }
+    if (invalid) {
+        std::cerr << "invalid: " << invalid << "\n";
+    }
+    std::cerr << "graded " << total << " sudokus on " << threads << " threads in " << time << "μs.\n";
+    return 0;
+}
@@ -0,0 +1,35 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "benchresult.hpp"
+
+// usage: ./merge partial_0.txt partial_1.txt ...
+//
+// combines the partial results written by ./bench --shard i/N --out ... into the report that
+// a single run over every shard's sudokus would have printed. every shard of the run must be
+// given exactly once, in any order, and all of them must come from the same input and count.
+int main(int argc, char* argv[]) {
+    if (argc <= 1) {
+        std::cout << "no partial results provided.\n";
+        return 1;
+    }
+
+    std::vector<BenchResult> parts(argc - 1);
+    for (int i = 1; i < argc; ++i) {
+        std::ifstream in(argv[i]);
+        if (!in.is_open() || !parts[i - 1].read(in)) {
+            std::cout << "could not read partial result from " << argv[i] << ".\n";
+            return 1;
+        }
+    }
+
+    BenchResult merged;
+    if (!merge_shards(parts, merged, std::cout)) {
+        return 1;
+    }
+
+    merged.report(std::cout);
+    return 0;
+}
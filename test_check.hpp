@@ -0,0 +1,21 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+
+// the test programs report each check as "name PASS" on stdout or "name FAIL" on stderr,
+// and return test_status() from main, so that a failing check also fails `make test`.
+inline int failed_checks = 0;
+
+inline void check(bool passed, const std::string& name) {
+    if (passed) {
+        std::cout << name << " PASS\n";
+    } else {
+        std::cerr << name << " FAIL\n";
+        ++failed_checks;
+    }
+}
+
+inline auto test_status() -> int {
+    return failed_checks == 0 ? 0 : 1;
+}